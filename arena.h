@@ -0,0 +1,98 @@
+#ifndef GRAPHICS_LAB2_ARENA_H
+#define GRAPHICS_LAB2_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Счётчики обращений к куче, сделанных через CountingAllocator (контейнеры загрузчика и Mesh).
+ */
+struct AllocationCounters {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytesAllocated = 0;
+};
+
+inline AllocationCounters &allocation_counters() {
+    static AllocationCounters counters;
+    return counters;
+}
+
+/**
+ * Аллокатор, который учитывает каждое выделение памяти в allocation_counters().
+ */
+template<typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    CountingAllocator() noexcept = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U> &) noexcept {}
+
+    /**
+     * Выход за зарезервированную ёмкость означает, что подсчёт элементов разошёлся с их разбором,
+     * поэтому это логическая ошибка, а не нехватка памяти.
+     */
+    T *allocate(size_t count) {
+        AllocationCounters &counters = allocation_counters();
+        counters.allocations++;
+        counters.bytesAllocated += count * sizeof(T);
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, size_t) noexcept {
+        allocation_counters().deallocations++;
+        ::operator delete(pointer);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U> &) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const CountingAllocator<U> &) const noexcept { return false; }
+};
+
+template<typename T>
+using CountedVector = std::vector<T, CountingAllocator<T>>;
+
+/**
+ * Монотонная арена: память выделяется один раз под заранее известное число элементов,
+ * затем раздаётся последовательными блоками и освобождается только целиком.
+ * Выданные указатели остаются действительными при перемещении арены.
+ */
+template<typename T>
+class MonotonicArena {
+public:
+    void reserve(size_t capacity) {
+        if (!storage.empty()) {
+            throw std::logic_error("Arena can only be reserved before the first allocation");
+        }
+        storage.reserve(capacity);
+    }
+
+    /**
+     * Выход за зарезервированную ёмкость означает, что подсчёт элементов разошёлся с их разбором,
+     * поэтому это логическая ошибка, а не нехватка памяти.
+     */
+    T *allocate(size_t count) {
+        if (storage.size() + count > storage.capacity()) {
+            throw std::logic_error("Arena allocation exceeds the reserved capacity");
+        }
+        size_t offset = storage.size();
+        storage.resize(offset + count);
+        return storage.data() + offset;
+    }
+
+    size_t size() const { return storage.size(); }
+
+    size_t capacity() const { return storage.capacity(); }
+
+private:
+    CountedVector<T> storage;
+};
+
+#endif //GRAPHICS_LAB2_ARENA_H
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "vector_math.h"
+
+/**
+ * Сравнивает прежний путь на double (Vector3/Point3 с аргументами по значению)
+ * с пакетными ядрами vector_math на float.
+ */
+
+using namespace vector_math;
+
+// Прежние типы из obj_loader.h, без изменений.
+struct Vector3 {
+    double x = 0.;
+    double y = 0.;
+    double z = 0.;
+
+public:
+    Vector3 cross_multiply(Vector3 that);
+};
+
+struct Point3 {
+    double x = 0.;
+    double y = 0.;
+    double z = 0.;
+
+public:
+    Vector3 operator-(Point3 that);
+};
+
+Vector3 Vector3::cross_multiply(Vector3 that) {
+    return Vector3{
+            .x = this->y * that.z - this->z * that.y,
+            .y = that.x * this->z - that.z * this->x,
+            .z = this->x * that.y - this->y * that.x,
+    };
+}
+
+Vector3 Point3::operator-(Point3 that) {
+    return Vector3{
+            .x = this->x - that.x,
+            .y = this->y - that.y,
+            .z = this->z - that.z,
+    };
+}
+
+static volatile double sink;
+
+template<typename Body>
+static double measure(Body body) {
+    const int repetitions = 100;
+    body();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) body();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+static void report(const char *name, double doubleMs, double floatMs) {
+    std::printf("%-18s double %8.3f ms   float %8.3f ms   %5.1fx\n", name, doubleMs, floatMs, doubleMs / floatMs);
+}
+
+int main(int argc, char **argv) {
+    // По умолчанию — число вершин граней в meshes/mug.obj
+    size_t count = argc > 1 ? (size_t) std::atol(argv[1]) : 118660;
+
+    std::vector<Point3> doublePoints(count);
+    std::vector<Vec3> floatPoints(count);
+    for (size_t i = 0; i < count; ++i) {
+        doublePoints[i] = {std::sin(i * 1.) * 50., std::cos(i * .7) * 40., i * .001};
+        floatPoints[i] = {(float) doublePoints[i].x, (float) doublePoints[i].y, (float) doublePoints[i].z};
+    }
+
+    // Масштаб: раньше каждая вершина делилась на meshScale, теперь тот же массив проходит transform_points.
+    double meshScale = 5.;
+    std::vector<Point3> doubleScaled(count);
+    double transformDouble = measure([&] {
+        for (size_t i = 0; i < count; ++i) {
+            const Point3 &point = doublePoints[i];
+            doubleScaled[i] = {point.x / meshScale, point.y / meshScale, point.z / meshScale};
+        }
+        sink = doubleScaled[count / 2].x;
+    });
+    std::vector<Vec3> floatScaled(count);
+    Mat4 scale = Mat4::scale(1.f / (float) meshScale);
+    double transformFloat = measure([&] {
+        transform_points(scale, floatPoints.data(), floatScaled.data(), count);
+        sink = floatScaled[count / 2].x;
+    });
+    report("transform", transformDouble, transformFloat);
+
+    // Нормали граней: разности вершин, векторное произведение и нормирование.
+    size_t faceCount = count / 3;
+    std::vector<Vector3> doubleNormals(faceCount);
+    double crossDouble = measure([&] {
+        for (size_t face = 0; face < faceCount; ++face) {
+            Point3 *p = &doublePoints[face * 3];
+            Vector3 normal = (p[1] - p[0]).cross_multiply(p[2] - p[0]);
+            double length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+            doubleNormals[face] = {normal.x / length, normal.y / length, normal.z / length};
+        }
+        sink = doubleNormals[0].x;
+    });
+    std::vector<Vec3> edges12(faceCount), edges13(faceCount), floatNormals(faceCount);
+    double crossFloat = measure([&] {
+        for (size_t face = 0; face < faceCount; ++face) {
+            const Vec3 *p = &floatPoints[face * 3];
+            edges12[face] = p[1] - p[0];
+            edges13[face] = p[2] - p[0];
+        }
+        cross_all(edges12.data(), edges13.data(), floatNormals.data(), faceCount);
+        normalize_all(floatNormals.data(), faceCount);
+        sink = floatNormals[0].x;
+    });
+    report("cross+normalize", crossDouble, crossFloat);
+
+    // Те же ядра на уже собранных рёбрах, без прохода по вершинам граней.
+    std::vector<Vector3> doubleEdges12(faceCount), doubleEdges13(faceCount);
+    for (size_t face = 0; face < faceCount; ++face) {
+        Point3 *p = &doublePoints[face * 3];
+        doubleEdges12[face] = p[1] - p[0];
+        doubleEdges13[face] = p[2] - p[0];
+    }
+    double kernelDouble = measure([&] {
+        for (size_t face = 0; face < faceCount; ++face) {
+            Vector3 normal = doubleEdges12[face].cross_multiply(doubleEdges13[face]);
+            double length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+            doubleNormals[face] = {normal.x / length, normal.y / length, normal.z / length};
+        }
+        sink = doubleNormals[0].x;
+    });
+    double kernelFloat = measure([&] {
+        cross_all(edges12.data(), edges13.data(), floatNormals.data(), faceCount);
+        normalize_all(floatNormals.data(), faceCount);
+        sink = floatNormals[0].x;
+    });
+    report("  kernels only", kernelDouble, kernelFloat);
+
+    double boundsDouble = measure([&] {
+        Point3 low = doublePoints[0], high = doublePoints[0];
+        for (const Point3 &point : doublePoints) {
+            low = {std::fmin(low.x, point.x), std::fmin(low.y, point.y), std::fmin(low.z, point.z)};
+            high = {std::fmax(high.x, point.x), std::fmax(high.y, point.y), std::fmax(high.z, point.z)};
+        }
+        sink = low.x + high.z;
+    });
+    double boundsFloat = measure([&] {
+        Bounds bounds = compute_bounds(floatPoints.data(), floatPoints.size());
+        sink = bounds.min.x + bounds.max.z;
+    });
+    report("bounds", boundsDouble, boundsFloat);
+
+    return 0;
+}
@@ -1,3 +1,5 @@
+#define GL_GLEXT_PROTOTYPES
+
 #include <GL/gl.h>
 #include <GL/glut.h>
 #include <iostream>
@@ -5,8 +7,13 @@
 #include <vector>
 #include <stack>
 #include <queue>
+#include <cstring>
 #include "SOIL/SOIL.h"
 #include "obj_loader.h"
+#include "vector_math.h"
+#include "vertex_compression.h"
+
+using vector_math::Mat4;
 
 GLuint texture_wall;
 GLuint texture_wood;
@@ -18,6 +25,19 @@ float pyramid_rotation_angle;        // Angle For The Triangle
 float cube_rotation_angle;    // Angle For The Quad
 Mesh teapot;
 
+/**
+ * Сжатая сетка и потоки, которые передаются в OpenGL без распаковки позиций в float.
+ */
+struct CompressedMeshBuffers {
+    vertex_compression::CompressedMesh mesh;
+    CountedVector<int8_t> normals;
+    // Текстурные координаты в float, если драйвер не принимает GL_HALF_FLOAT в glTexCoordPointer
+    CountedVector<float> textureFallback;
+};
+
+CompressedMeshBuffers teapotCompressed;
+bool shouldUseCompressedMesh = false;
+
 enum class LightType {
     DIRECTED = 1,
     POINT = 2,
@@ -36,6 +56,10 @@ void drawPyramid();
 
 void drawMesh(Mesh &mesh);
 
+void drawCompressedMesh(const CompressedMeshBuffers &buffers);
+
+void loadMesh(const char *path);
+
 void placeAndRotateCamera();
 
 void load_texture(const char *imageFilename, GLuint *textureId);
@@ -54,11 +78,51 @@ void init() {
 
     load_texture("textures/wall.jpg", &texture_wall);
     load_texture("textures/wood.png", &texture_wood);
-    teapot = obj_loader::load_obj("meshes/heart.obj");
+    loadMesh("meshes/heart.obj");
 
     glEnable(GL_CULL_FACE);
 }
 
+/**
+ * Загружает сетку; в сжатом режиме несжатая копия сразу освобождается.
+ * Печатает, сколько байт вершинных данных хранится в памяти и сколько передаётся в OpenGL за кадр.
+ */
+void loadMesh(const char *path) {
+    teapot = obj_loader::load_obj(path);
+    size_t vertexCount = teapot.faceVertices.size();
+    size_t residentBytes;
+    size_t uploadedBytes;
+
+    if (shouldUseCompressedMesh) {
+        teapotCompressed.mesh = vertex_compression::compress(teapot);
+        teapot = Mesh();
+        // После распаковки в GL_BYTE октаэдрические нормали больше не нужны.
+        vertex_compression::decode_normals_snorm8(teapotCompressed.mesh, teapotCompressed.normals);
+        teapotCompressed.mesh.normals = CountedVector<int16_t>();
+
+        size_t textureBytes = 2 * sizeof(uint16_t);
+        if (!glutExtensionSupported("GL_ARB_half_float_vertex")) {
+            const CountedVector<uint16_t> &halves = teapotCompressed.mesh.textures;
+            teapotCompressed.textureFallback.resize(halves.size());
+            for (size_t i = 0; i < halves.size(); ++i) {
+                teapotCompressed.textureFallback[i] = vertex_compression::half_to_float(halves[i]);
+            }
+            teapotCompressed.mesh.textures = CountedVector<uint16_t>();
+            textureBytes = 2 * sizeof(float);
+        }
+
+        residentBytes = teapotCompressed.mesh.residentSize() + teapotCompressed.normals.size()
+                        + teapotCompressed.textureFallback.size() * sizeof(float);
+        uploadedBytes = vertexCount * (3 * sizeof(GLshort) + 3 * sizeof(GLbyte) + textureBytes);
+    } else {
+        residentBytes = vertexCount * sizeof(FaceVertex) + teapot.faces.size() * sizeof(Face);
+        uploadedBytes = vertexCount * sizeof(FaceVertex);
+    }
+
+    std::cout << "Mesh vertex data: " << residentBytes << " bytes resident, "
+              << uploadedBytes << " bytes sent to OpenGL per frame" << std::endl;
+}
+
 void load_texture(const char *imageFilename, GLuint *textureId) {
     int width, height;
     unsigned char *image = SOIL_load_image(imageFilename, &width, &height, nullptr, SOIL_LOAD_RGB);
@@ -106,11 +170,12 @@ GLdouble camY = 0.;
  * Устанавливает положение и угол обзора камеры.
  */
 void placeAndRotateCamera() {
-    GLdouble camX = sin(cameraAngleY) * cameraRadius;
-    GLdouble camZ = cos(cameraAngleY) * cameraRadius;
-    gluLookAt(camX, camY, camZ,
-              0, 0, 0,
-              0.0f, 1.0f, 0.0f);
+    GLfloat camX = sin(cameraAngleY) * cameraRadius;
+    GLfloat camZ = cos(cameraAngleY) * cameraRadius;
+    Mat4 view = Mat4::look_at({camX, (GLfloat) camY, camZ},
+                              {0.f, 0.f, 0.f},
+                              {0.f, 1.f, 0.f});
+    glMultMatrixf(view.data());
 }
 
 void mainLoop() {
@@ -207,7 +272,8 @@ void mainLoop() {
     drawWall();
     drawPyramid();
     drawCube();
-    drawMesh(teapot);
+    if (shouldUseCompressedMesh) drawCompressedMesh(teapotCompressed);
+    else drawMesh(teapot);
 
     pyramid_rotation_angle += 0.5f;
     cube_rotation_angle -= 0.15f;
@@ -224,24 +290,31 @@ GLfloat COLOR_RED[3] = {.67, .18, .15};
 GLfloat COLOR_GREEN[3] = {.0, .59, .54};
 GLfloat COLOR_BLUE[3] = {.02, .67, .96};
 
-void drawMesh(Mesh &mesh) {
-    glPushMatrix();
-    glTranslated(0., -2.5, -5.);
-    glRotated(-5, 1., 1., 1.);
-    glRotated(-90, 1., 0., 0.);
-    double meshScale = 5.;
+/**
+ * Переносит сетку на место в сцене и задаёт её цвет и текстуру.
+ */
+void placeMesh() {
+    const float meshScale = 5.f;
+    static const Mat4 model = Mat4::translation({0.f, -2.5f, -5.f})
+                              * Mat4::rotation(-5.f, {1.f, 1.f, 1.f})
+                              * Mat4::rotation(-90.f, {1.f, 0.f, 0.f})
+                              * Mat4::scale(1.f / meshScale);
+    glMultMatrixf(model.data());
     glColor3fv(COLOR_RED);
 
     glBindTexture(GL_TEXTURE_2D, texture_wood);
+}
+
+void drawMesh(Mesh &mesh) {
+    glPushMatrix();
+    placeMesh();
 
-    for (Face const &face: teapot.faces) {
+    for (Face const &face: mesh.faces) {
         glBegin(GL_POLYGON);
-        for (FaceVertex vertex : face.vertices) {
-            glTexCoord3d(vertex.texture.x, vertex.texture.y, vertex.texture.z);
-            glNormal3d(vertex.normal.x, vertex.normal.y, vertex.normal.z);
-            glVertex3d(vertex.position.x / meshScale,
-                       vertex.position.y / meshScale,
-                       vertex.position.z / meshScale);
+        for (FaceVertex const &vertex : face.vertices) {
+            glTexCoord3fv(vertex.texture.data());
+            glNormal3fv(vertex.normal.data());
+            glVertex3fv(vertex.position.data());
         }
         glEnd();
     }
@@ -250,6 +323,38 @@ void drawMesh(Mesh &mesh) {
     glPopMatrix();
 }
 
+/**
+ * Рисует сжатую сетку без распаковки: позиции передаются как GL_SHORT, а их масштаб и сдвиг
+ * входят в матрицу модели; нормали — как GL_BYTE, текстурные координаты — как GL_HALF_FLOAT.
+ */
+void drawCompressedMesh(const CompressedMeshBuffers &buffers) {
+    const vertex_compression::CompressedMesh &mesh = buffers.mesh;
+
+    glPushMatrix();
+    placeMesh();
+    glMultMatrixf(mesh.positionDecodeMatrix().data());
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_SHORT, 0, mesh.positions.data());
+    glNormalPointer(GL_BYTE, 0, buffers.normals.data());
+    if (buffers.textureFallback.empty()) {
+        glTexCoordPointer(2, GL_HALF_FLOAT, 0, mesh.textures.data());
+    } else {
+        glTexCoordPointer(2, GL_FLOAT, 0, buffers.textureFallback.data());
+    }
+
+    glMultiDrawArrays(GL_POLYGON, mesh.faceFirsts.data(), mesh.faceSizes.data(), (GLsizei) mesh.faceCount());
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopMatrix();
+}
+
 /**
  * Рисует пирамидку.
  */
@@ -494,6 +599,9 @@ void specialKeyHandler(int key, int x, int y) {
 
 int main(int argc, char **argv) {
     glutInit(&argc, argv);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--compressed") == 0) shouldUseCompressedMesh = true;
+    }
     glutInitDisplayMode(GLUT_DEPTH | GLUT_DOUBLE | GLUT_RGBA); // Display Mode
     glutInitWindowSize(1280, 800);
     glutCreateWindow("Laboratory work 2");
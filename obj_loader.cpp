@@ -1,11 +1,12 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <vector>
-#include <regex>
+#include <cstdlib>
+#include <cstring>
 #include "obj_loader.h"
 
 using namespace std;
+using namespace vector_math;
 
 namespace obj_loader {
 
@@ -15,139 +16,284 @@ namespace obj_loader {
         size_t normalVectorOrdinal;
     };
 
-    static const std::regex FACE_VERTEX_DEFINITION_PATTERN("^([0-9]+)(/([0-9]+)?(/([0-9]+)?)?)?$");
+    /**
+     * Количество записей каждого вида, найденных при первом проходе по файлу.
+     */
+    struct RecordCounts {
+        size_t vertices = 0;
+        size_t textureVertices = 0;
+        size_t normals = 0;
+        size_t faces = 0;
+        size_t faceVertices = 0;
+    };
+
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static const char *skipBlanks(const char *position, const char *end) {
+        while (position < end && isBlank(*position)) ++position;
+        return position;
+    }
+
+    static const char *skipToken(const char *position, const char *end) {
+        while (position < end && !isBlank(*position)) ++position;
+        return position;
+    }
+
+    static bool tokenEquals(const char *begin, const char *end, const char *literal) {
+        size_t length = strlen(literal);
+        return (size_t) (end - begin) == length && strncmp(begin, literal, length) == 0;
+    }
 
-    FaceVertexDefinition parseVertexDefinition(string &definition) {
+    /**
+     * Читает число с плавающей точкой, не выходя за пределы строки.
+     * Если числа нет, значение остаётся нулевым, как при чтении из потока.
+     */
+    static const char *readFloat(const char *position, const char *end, float &value) {
+        position = skipBlanks(position, end);
+        if (position == end) return end;
+        char *numberEnd;
+        float parsed = strtof(position, &numberEnd);
+        if (numberEnd == position || numberEnd > end) return end;
+        value = parsed;
+        return numberEnd;
+    }
+
+    static const char *readVector(const char *position, const char *end, Vec3 &vector) {
+        position = readFloat(position, end, vector.x);
+        position = readFloat(position, end, vector.y);
+        return readFloat(position, end, vector.z);
+    }
+
+    static const char *readOrdinal(const char *position, const char *end, size_t &ordinal) {
+        ordinal = 0;
+        while (position < end && *position >= '0' && *position <= '9') {
+            ordinal = ordinal * 10 + (*position - '0');
+            ++position;
+        }
+        return position;
+    }
+
+    /**
+     * Разбирает определение вершины грани вида "v", "v/t", "v//n" или "v/t/n".
+     */
+    FaceVertexDefinition parseVertexDefinition(const char *begin, const char *end) {
         FaceVertexDefinition result{
                 .vertexOrdinal = 0,
                 .textureVertexOrdinal = 0,
                 .normalVectorOrdinal = 0,
         };
 
-        std::smatch matchResults;
-        std::regex_match(definition, matchResults, FACE_VERTEX_DEFINITION_PATTERN);
-
-        try {
-            result.vertexOrdinal = stoi(matchResults[1].str());
-        } catch (invalid_argument &error) {
-            throw std::runtime_error(std::string("Invalid face vertex index: '") + error.what() + "'");
-        }
+        const char *position = readOrdinal(begin, end, result.vertexOrdinal);
+        bool isValid = position != begin;
 
-        try {
-            result.textureVertexOrdinal = stoi(matchResults[3].str());
-        } catch (invalid_argument &ignored) {
-            result.textureVertexOrdinal = 0;
+        if (isValid && position < end && *position == '/') {
+            position = readOrdinal(position + 1, end, result.textureVertexOrdinal);
+            if (position < end && *position == '/') {
+                position = readOrdinal(position + 1, end, result.normalVectorOrdinal);
+            }
         }
 
-        try {
-            result.normalVectorOrdinal = stoi(matchResults[5].str());
-        } catch (invalid_argument &ignored) {
-            result.normalVectorOrdinal = 0;
+        if (!isValid || position != end) {
+            throw std::runtime_error("Invalid face vertex index: '" + std::string(begin, end) + "'");
         }
 
         return result;
     }
 
-    Mesh load_obj(const char *path) {
-        cout << "Loading OBJ file..." << endl;
-
-        std::vector<Point3> vertices;
-        std::vector<Point3> textureVertices;
-        std::vector<Vector3> normals;
+    template<typename T>
+    static const T &elementAt(const CountedVector<T> &elements, size_t ordinal, const char *kind) {
+        if (ordinal == 0 || ordinal > elements.size()) {
+            throw std::runtime_error(std::string("Face refers to a missing ") + kind + " #" + to_string(ordinal));
+        }
+        return elements[ordinal - 1];
+    }
 
-        ifstream file;
-        file.open(path);
+    /**
+     * Читает файл целиком в один буфер, завершённый нулевым символом.
+     */
+    static CountedVector<char> readFile(const char *path) {
+        ifstream file(path, ios::in | ios::binary | ios::ate);
         if (!file.is_open()) {
             throw std::runtime_error(std::string("Failed to open file '") + path + "' for reading");
         }
 
-        Mesh mesh = Mesh();
+        streamoff size = file.tellg();
+        if (size < 0) {
+            throw std::runtime_error(std::string("Failed to read file '") + path + "'");
+        }
+
+        CountedVector<char> contents((size_t) size + 1, '\0');
+        file.seekg(0);
+        if (!file.read(contents.data(), size)) {
+            throw std::runtime_error(std::string("Failed to read file '") + path + "'");
+        }
+
+        return contents;
+    }
+
+    /**
+     * Вызывает handler(op, opEnd, arguments, lineEnd) для каждой непустой строки файла.
+     */
+    template<typename Handler>
+    static void forEachLine(const CountedVector<char> &contents, Handler handler) {
+        const char *position = contents.data();
+        const char *end = contents.data() + contents.size() - 1;
+
+        while (position < end) {
+            const char *lineEnd = static_cast<const char *>(memchr(position, '\n', end - position));
+            if (lineEnd == nullptr) lineEnd = end;
+
+            const char *op = skipBlanks(position, lineEnd);
+            const char *opEnd = skipToken(op, lineEnd);
+            if (op != opEnd) {
+                handler(op, opEnd, opEnd, lineEnd);
+            }
+
+            position = lineEnd + 1;
+        }
+    }
+
+    static RecordCounts countRecords(const CountedVector<char> &contents) {
+        RecordCounts counts;
+        forEachLine(contents, [&counts](const char *op, const char *opEnd, const char *position, const char *end) {
+            if (tokenEquals(op, opEnd, "v")) {
+                counts.vertices++;
+            } else if (tokenEquals(op, opEnd, "vn")) {
+                counts.normals++;
+            } else if (tokenEquals(op, opEnd, "vt")) {
+                counts.textureVertices++;
+            } else if (tokenEquals(op, opEnd, "f")) {
+                counts.faces++;
+                while ((position = skipBlanks(position, end)) != end) {
+                    position = skipToken(position, end);
+                    counts.faceVertices++;
+                }
+            }
+        });
+        return counts;
+    }
+
+    /**
+     * Заменяет нормали вершин указанных граней единичной нормалью плоскости,
+     * проходящей через первые три вершины грани.
+     */
+    static void calculateFaceNormals(Mesh &mesh, const CountedVector<size_t> &faceIndices) {
+        size_t count = faceIndices.size();
+        CountedVector<Vec3> edges12(count);
+        CountedVector<Vec3> edges13(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Face &face = mesh.faces[faceIndices[i]];
+            edges12[i] = face.vertices[1].position - face.vertices[0].position;
+            edges13[i] = face.vertices[2].position - face.vertices[0].position;
+        }
+
+        CountedVector<Vec3> &calculatedNormals = edges12;
+        cross_all(edges12.data(), edges13.data(), calculatedNormals.data(), count);
+        normalize_all(calculatedNormals.data(), count);
 
-        string lineOfText;
-        while (getline(file, lineOfText)) {
-            istringstream line(lineOfText);
-            std::string op;
-            line >> op;
+        for (size_t i = 0; i < count; ++i) {
+            for (auto &vertex : mesh.faces[faceIndices[i]].vertices) {
+                vertex.normal = calculatedNormals[i];
+            }
+        }
+    }
 
-            if (op == "#" || op.empty()) {
-                // Comment, ignore line
+    Mesh load_obj(const char *path) {
+        cout << "Loading OBJ file..." << endl;
 
-            } else if (op == "v") {
+        // Первый проход только считает записи, чтобы дальше вся память выделялась ровно один раз.
+        CountedVector<char> contents = readFile(path);
+        RecordCounts counts = countRecords(contents);
+
+        CountedVector<Vec3> vertices;
+        CountedVector<Vec3> textureVertices;
+        CountedVector<Vec3> normals;
+        vertices.reserve(counts.vertices);
+        textureVertices.reserve(counts.textureVertices);
+        normals.reserve(counts.normals);
+
+        // Второй проход читает атрибуты вершин.
+        forEachLine(contents, [&](const char *op, const char *opEnd, const char *position, const char *end) {
+            Vec3 vector;
+            if (tokenEquals(op, opEnd, "v")) {
                 // Vertex
-                Point3 point;
-                line >> point.x >> point.y >> point.z;
-                vertices.push_back(point);
+                readVector(position, end, vector);
+                vertices.push_back(vector);
 
-            } else if (op == "vn") {
+            } else if (tokenEquals(op, opEnd, "vn")) {
                 // Normal vector for a vertex
-                Vector3 normal;
-                line >> normal.x >> normal.y >> normal.z;
-                normals.push_back(normal);
+                readVector(position, end, vector);
+                normals.push_back(vector);
+
+            } else if (tokenEquals(op, opEnd, "vt")) {
+                readVector(position, end, vector);
+                textureVertices.push_back(vector);
+            }
+        });
 
-            } else if (op == "vt") {
-                Point3 point;
-                line >> point.x >> point.y >> point.z;
-                textureVertices.push_back(point);
+        normalize_all(normals.data(), normals.size());
 
-            } else if (op == "f") {
+        Mesh mesh = Mesh();
+        mesh.bounds = compute_bounds(vertices.data(), vertices.size());
+        mesh.faces.reserve(counts.faces);
+        mesh.faceVertices.reserve(counts.faceVertices);
+
+        CountedVector<size_t> facesWithoutNormals;
+        facesWithoutNormals.reserve(counts.faces);
+
+        // Третий проход собирает грани из прочитанных атрибутов.
+        forEachLine(contents, [&](const char *op, const char *opEnd, const char *position, const char *end) {
+            if (tokenEquals(op, opEnd, "#") || tokenEquals(op, opEnd, "v")
+                || tokenEquals(op, opEnd, "vn") || tokenEquals(op, opEnd, "vt")) {
+                // Comment or vertex attribute, already handled
+
+            } else if (tokenEquals(op, opEnd, "f")) {
                 // Face
+                size_t vertexCount = 0;
+                for (const char *token = position; (token = skipBlanks(token, end)) != end; ++vertexCount) {
+                    token = skipToken(token, end);
+                }
+
                 Face face;
-                string vertexDefinition;
+                face.vertices.first = mesh.faceVertices.allocate(vertexCount);
+                face.vertices.count = vertexCount;
+
                 bool shouldCalculateNormals = false;
-                while (line >> vertexDefinition) {
-                    FaceVertex faceVertex;
-                    FaceVertexDefinition faceVertexDefinition = parseVertexDefinition(vertexDefinition);
-                    faceVertex.position = vertices[faceVertexDefinition.vertexOrdinal - 1];
+                for (FaceVertex &faceVertex : face.vertices) {
+                    const char *token = skipBlanks(position, end);
+                    position = skipToken(token, end);
+                    FaceVertexDefinition faceVertexDefinition = parseVertexDefinition(token, position);
+                    faceVertex.position = elementAt(vertices, faceVertexDefinition.vertexOrdinal, "vertex");
 
                     if (faceVertexDefinition.textureVertexOrdinal != 0) {
-                        faceVertex.texture = textureVertices[faceVertexDefinition.textureVertexOrdinal - 1];
+                        faceVertex.texture = elementAt(textureVertices, faceVertexDefinition.textureVertexOrdinal,
+                                                       "texture vertex");
                     }
 
                     if (faceVertexDefinition.normalVectorOrdinal != 0) {
-                        faceVertex.normal = normals[faceVertexDefinition.normalVectorOrdinal - 1];
+                        faceVertex.normal = elementAt(normals, faceVertexDefinition.normalVectorOrdinal, "normal");
                     } else {
                         shouldCalculateNormals = true;
                     }
-
-                    face.vertices.push_back(faceVertex);
                 }
 
-                if (shouldCalculateNormals) {
+                if (shouldCalculateNormals && vertexCount >= 3) {
                     cerr << "Some normals not present for a face, calculating normal vectors" << endl;
-                    Vector3 v12 = face.vertices[1].position - face.vertices[0].position;
-                    Vector3 v13 = face.vertices[2].position - face.vertices[0].position;
-                    const Vector3 &calculatedNormal = v12.cross_multiply(v13);
-
-                    for (auto &vertex : face.vertices) {
-                        vertex.normal = calculatedNormal;
-                    }
+                    facesWithoutNormals.push_back(mesh.faces.size());
                 }
 
                 mesh.faces.push_back(face);
 
             } else {
-                cerr << "Unsupported operation '" << op << "'" << endl;
+                cerr << "Unsupported operation '";
+                cerr.write(op, opEnd - op) << "'" << endl;
             }
-        }
+        });
 
-        file.close();
+        calculateFaceNormals(mesh, facesWithoutNormals);
 
         return mesh;
     }
 }
-
-Vector3 Vector3::cross_multiply(Vector3 that) {
-    return Vector3{
-            .x = this->y * that.z - this->z * that.y,
-            .y = that.x * this->z - that.z * this->x,
-            .z = this->x * that.y - this->y * that.x,
-    };
-}
-
-Vector3 Point3::operator-(Point3 that) {
-    return Vector3{
-            .x = this->x - that.x,
-            .y = this->y - that.y,
-            .z = this->z - that.z,
-    };
-}
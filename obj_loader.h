@@ -5,44 +5,68 @@
 #ifndef GRAPHICS_LAB2_OBJ_LOADER_H
 #define GRAPHICS_LAB2_OBJ_LOADER_H
 
+#include <cstddef>
 #include <vector>
+#include "arena.h"
+#include "vector_math.h"
 
-struct Vector3 {
-    double x = 0.;
-    double y = 0.;
-    double z = 0.;
+static constexpr vector_math::Vec3 DEFAULT_TEXTURE_VERTEX = {0.f, 0.f, 0.f};
+static constexpr vector_math::Vec3 DEFAULT_NORMAL_VECTOR = {0.f, 0.f, 1.f};
 
+class FaceVertex {
 public:
-    Vector3 cross_multiply(Vector3 that);
+    vector_math::Vec3 position;
+    vector_math::Vec3 normal = DEFAULT_NORMAL_VECTOR;
+    vector_math::Vec3 texture = DEFAULT_TEXTURE_VERTEX;
 };
 
-struct Point3 {
-    double x = 0.;
-    double y = 0.;
-    double z = 0.;
-
+/**
+ * Вершины грани: непрерывный участок арены, которой владеет Mesh.
+ */
+class FaceVertexRange {
 public:
-    Vector3 operator-(Point3 that);
-};
+    FaceVertex *first = nullptr;
+    size_t count = 0;
 
-static const Point3 DEFAULT_TEXTURE_VERTEX = {0., 0., 0.};
-static const Vector3 DEFAULT_NORMAL_VECTOR = {0., 0., 1.};
+    FaceVertex *begin() { return first; }
 
-class FaceVertex {
-public:
-    Point3 position;
-    Vector3 normal = DEFAULT_NORMAL_VECTOR;
-    Point3 texture = DEFAULT_TEXTURE_VERTEX;
+    FaceVertex *end() { return first + count; }
+
+    const FaceVertex *begin() const { return first; }
+
+    const FaceVertex *end() const { return first + count; }
+
+    size_t size() const { return count; }
+
+    FaceVertex &operator[](size_t index) { return first[index]; }
+
+    const FaceVertex &operator[](size_t index) const { return first[index]; }
 };
 
 class Face {
 public:
-    std::vector<FaceVertex> vertices;
+    FaceVertexRange vertices;
 };
 
+/**
+ * Сетка владеет вершинами всех своих граней, поэтому её можно перемещать, но не копировать:
+ * копия граней ссылалась бы на арену оригинала.
+ */
 class Mesh {
 public:
-    std::vector<Face> faces = std::vector<Face>();
+    CountedVector<Face> faces;
+    MonotonicArena<FaceVertex> faceVertices;
+    vector_math::Bounds bounds;
+
+    Mesh() = default;
+
+    Mesh(Mesh &&) = default;
+
+    Mesh &operator=(Mesh &&) = default;
+
+    Mesh(const Mesh &) = delete;
+
+    Mesh &operator=(const Mesh &) = delete;
 };
 
 namespace obj_loader {
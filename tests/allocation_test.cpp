@@ -0,0 +1,51 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "obj_loader.h"
+#include "test_support.h"
+
+/**
+ * Проверяет, что загрузка сетки делает O(1) обращений к куче, а не O(граней).
+ * Считаются все выделения памяти в процессе через замену глобального operator new.
+ */
+
+static size_t globalAllocations = 0;
+
+void *operator new(size_t size) {
+    globalAllocations++;
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+// Верхняя граница числа выделений на одну загрузку, не зависящая от размера файла.
+static const size_t MAX_ALLOCATIONS_PER_LOAD = 16;
+
+static void checkMesh(const char *path) {
+    size_t allocationsBefore = globalAllocations;
+    size_t countedBefore = allocation_counters().allocations;
+    size_t faceCount;
+    {
+        Mesh mesh = obj_loader::load_obj(path);
+        faceCount = mesh.faces.size();
+    }
+    size_t allocations = globalAllocations - allocationsBefore;
+    size_t counted = allocation_counters().allocations - countedBefore;
+
+    std::printf("%s: %zu faces, %zu heap allocations (%zu through CountingAllocator)\n",
+                path, faceCount, allocations, counted);
+    test_support::check(allocations <= MAX_ALLOCATIONS_PER_LOAD, "heap allocations per load", path, allocations);
+    test_support::check(counted <= allocations, "CountingAllocator sees no more than operator new", path, counted);
+}
+
+int main(int argc, char **argv) {
+    return test_support::for_each_mesh(argc, argv, checkMesh);
+}
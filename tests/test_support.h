@@ -0,0 +1,60 @@
+#ifndef GRAPHICS_LAB2_TEST_SUPPORT_H
+#define GRAPHICS_LAB2_TEST_SUPPORT_H
+
+#include <cstddef>
+#include <cmath>
+#include <cstdio>
+#include "vector_math.h"
+
+/**
+ * Общие помощники тестов: счётчик проваленных проверок и main для тестов, которым передаются пути к сеткам.
+ */
+namespace test_support {
+
+    inline int &failures() {
+        static int count = 0;
+        return count;
+    }
+
+    /**
+     * Засчитывает проверку; первые 20 провалов печатаются вместе с контекстом (путь к сетке, длина массива)
+     * и номером элемента.
+     */
+    inline void check(bool condition, const char *what, const char *context, size_t index) {
+        if (!condition) {
+            if (failures() < 20) std::printf("FAIL %s (%s, %zu)\n", what, context, index);
+            failures()++;
+        }
+    }
+
+    /**
+     * Векторы совпадают с относительной погрешностью tolerance (абсолютной для векторов короче единицы).
+     */
+    inline bool near(const vector_math::Vec3 &a, const vector_math::Vec3 &b, float tolerance) {
+        float scale = std::fmax(1.f, std::fmax(length(a), length(b)));
+        return length(a - b) <= tolerance * scale;
+    }
+
+    inline int report() {
+        std::printf(failures() == 0 ? "PASS\n" : "FAIL: %d checks\n", failures());
+        return failures() == 0 ? 0 : 1;
+    }
+
+    /**
+     * Вызывает checkMesh(path) для каждого пути из командной строки и возвращает код завершения теста.
+     */
+    template<typename CheckMesh>
+    int for_each_mesh(int argc, char **argv, CheckMesh checkMesh) {
+        if (argc < 2) {
+            std::fprintf(stderr, "Usage: %s <mesh.obj>...\n", argv[0]);
+            return 2;
+        }
+
+        for (int i = 1; i < argc; ++i) {
+            checkMesh(argv[i]);
+        }
+        return report();
+    }
+}
+
+#endif //GRAPHICS_LAB2_TEST_SUPPORT_H
@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "vector_math.h"
+#include "test_support.h"
+
+/**
+ * Сравнивает векторные ядра vector_math с их скалярными аналогами
+ * на массивах всех длин от 0 до 40, чтобы затронуть и блоки по четыре, и хвосты.
+ * Собирается дважды: с SSE и с VECTOR_MATH_NO_SIMD, где остаётся только скалярный код.
+ */
+
+using namespace vector_math;
+using test_support::check;
+using test_support::near;
+
+#if defined(VECTOR_MATH_NO_SIMD) && defined(VECTOR_MATH_SSE)
+#error "VECTOR_MATH_NO_SIMD must disable the SSE kernels"
+#endif
+
+static std::vector<Vec3> randomVectors(size_t count, unsigned &seed) {
+    std::vector<Vec3> result(count);
+    for (Vec3 &v : result) {
+        float c[3];
+        for (float &component : c) {
+            seed = seed * 1664525u + 1013904223u;
+            component = (float) ((seed >> 8) % 20001) / 100.f - 100.f;
+        }
+        v = {c[0], c[1], c[2]};
+    }
+    return result;
+}
+
+static bool equal(const Mat4 &a, const Mat4 &b, float tolerance) {
+    for (int i = 0; i < 16; ++i) {
+        if (std::fabs(a.m[i] - b.m[i]) > tolerance) return false;
+    }
+    return true;
+}
+
+int main() {
+    const float tolerance = 1e-6f;
+    unsigned seed = 12345;
+
+    for (size_t count = 0; count <= 40; ++count) {
+        std::vector<Vec3> a = randomVectors(count, seed);
+        std::vector<Vec3> b = randomVectors(count, seed);
+        if (count > 2) a[2] = Vec3();
+
+#ifdef VECTOR_MATH_SSE
+        for (size_t i = 0; i + 4 <= count; i += 4) {
+            __m128 x, y, z;
+            detail::load4(a.data() + i, x, y, z);
+            alignas(16) float xs[4], ys[4], zs[4];
+            _mm_store_ps(xs, x);
+            _mm_store_ps(ys, y);
+            _mm_store_ps(zs, z);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                check(Vec3(xs[lane], ys[lane], zs[lane]) == a[i + lane], "load4 lane order", "count", count);
+            }
+            Vec3 stored[4];
+            detail::store4(stored, x, y, z);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                check(stored[lane] == a[i + lane], "store4 round trip", "count", count);
+            }
+        }
+#endif
+
+        std::vector<Vec3> normalized = a;
+        normalize_all(normalized.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            check(near(normalized[i], normalize(a[i]), tolerance), "normalize_all", "count", count);
+        }
+        if (count > 2) check(normalized[2] == Vec3(), "normalize_all keeps zero vectors", "count", count);
+
+        std::vector<Vec3> crossed(count);
+        cross_all(a.data(), b.data(), crossed.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            check(near(crossed[i], cross(a[i], b[i]), tolerance), "cross_all", "count", count);
+        }
+
+        std::vector<Vec3> inPlace = a;
+        cross_all(inPlace.data(), b.data(), inPlace.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            check(near(inPlace[i], crossed[i], tolerance), "cross_all in place", "count", count);
+        }
+
+        Mat4 model = Mat4::translation({1.f, -2.f, 3.f}) * Mat4::rotation(25.f, {1.f, 2.f, 3.f}) * Mat4::scale(.2f);
+        std::vector<Vec3> transformed(count);
+        transform_points(model, a.data(), transformed.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            check(near(transformed[i], transform_point(model, a[i]), tolerance), "transform_points", "count",
+                  count);
+        }
+
+        std::vector<Vec3> transformedInPlace = a;
+        transform_points(model, transformedInPlace.data(), transformedInPlace.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            check(transformedInPlace[i] == transformed[i], "transform_points in place", "count", count);
+        }
+
+        Bounds bounds = compute_bounds(a.data(), count);
+        Bounds expected;
+        if (count > 0) expected = {a[0], a[0]};
+        for (const Vec3 &v : a) {
+            expected.min = min(expected.min, v);
+            expected.max = max(expected.max, v);
+        }
+        check(bounds.min == expected.min && bounds.max == expected.max, "compute_bounds", "count", count);
+    }
+
+    Mat4 a = Mat4::translation({1.f, -2.f, 3.f}) * Mat4::rotation(33.f, {1.f, 1.f, 1.f});
+    Mat4 b = Mat4::rotation(-70.f, {0.f, 1.f, 0.f}) * Mat4::scale(.2f);
+    Mat4 product = a * b;
+    Mat4 expected;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            for (int k = 0; k < 4; ++k) expected(row, column) += a(row, k) * b(k, column);
+        }
+    }
+    check(equal(product, expected, tolerance), "Mat4 multiplication", "matrix", 0);
+    check(equal(Mat4::identity() * a, a, 0.f), "Mat4 identity", "matrix", 0);
+
+    check(near(transform_point(Mat4::rotation(90.f, {0.f, 0.f, 1.f}), {1.f, 0.f, 0.f}), {0.f, 1.f, 0.f}, tolerance),
+          "Mat4::rotation matches glRotatef", "matrix", 0);
+    check(near(transform_point(Mat4::look_at({0.f, 0.f, 10.f}, {0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}), {}),
+               {0.f, 0.f, -10.f}, tolerance), "Mat4::look_at matches gluLookAt", "matrix", 0);
+
+    static_assert(cross(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f)) == Vec3(0.f, 0.f, 1.f), "constexpr cross");
+    static_assert(transform_point(Mat4::translation({1.f, 2.f, 3.f}), Vec3(1.f, 1.f, 1.f)) == Vec3(2.f, 3.f, 4.f),
+                  "constexpr transform_point");
+
+#ifdef VECTOR_MATH_SSE
+    std::printf("SSE kernels: ");
+#else
+    std::printf("scalar fallback: ");
+#endif
+    return test_support::report();
+}
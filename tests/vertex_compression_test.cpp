@@ -0,0 +1,125 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include "obj_loader.h"
+#include "vertex_compression.h"
+#include "test_support.h"
+
+/**
+ * Проверяет границы погрешности сжатого формата вершин на каждой переданной сетке
+ * и совпадение векторной и скалярной распаковки.
+ */
+
+using namespace vector_math;
+using namespace vertex_compression;
+using test_support::check;
+using test_support::near;
+
+// Угловая погрешность октаэдрического кодирования в 2×16 бит (измерено: не более 6.3e-5 рад).
+static const float MAX_NORMAL_ERROR = 1e-4f;
+// Половина шага half float в единицах значения: 2^-11 относительно и 2^-25 для денормализованных чисел.
+static const float HALF_RELATIVE_ERROR = 1.f / 2048.f;
+static const float HALF_ABSOLUTE_ERROR = 1.f / 33554432.f;
+// Нормали для glNormalPointer(GL_BYTE): половина шага 1/127 по каждой оси.
+static const float MAX_SNORM8_NORMAL_ERROR = 0.5f / 127.f * 1.7321f + MAX_NORMAL_ERROR;
+
+static float angleBetween(const Vec3 &a, const Vec3 &b) {
+    return 2.f * std::asin(std::fmin(1.f, length(a - b) / 2.f));
+}
+
+static void checkHalfRoundTrip() {
+    for (uint32_t half = 0; half <= 0xffff; ++half) {
+        float value = half_to_float((uint16_t) half);
+        if (std::isnan(value)) continue;
+        check(float_to_half(value) == half, "half round trip", "half", half);
+    }
+}
+
+static void checkMesh(const char *path) {
+    Mesh mesh = obj_loader::load_obj(path);
+    CompressedMesh compressed = compress(mesh);
+
+    VertexStreams streams;
+    VertexStreams scalarStreams;
+    decompress(compressed, streams);
+    decompress_scalar(compressed, scalarStreams);
+
+    CountedVector<int8_t> normals8;
+    decode_normals_snorm8(compressed, normals8);
+
+    check(compressed.faceCount() == mesh.faces.size(), "face count", path, 0);
+
+    Vec3 extent = compressed.bounds.extent();
+    float halfCube = std::fmax(extent.x, std::fmax(extent.y, extent.z)) * .5f;
+    Vec3 center = compressed.bounds.center();
+    float magnitude = std::fmax(std::fabs(center.x), std::fmax(std::fabs(center.y), std::fabs(center.z))) + halfCube;
+    float maxPositionError = .5f * halfCube / 32767.f + 4.f * FLT_EPSILON * magnitude;
+
+    float positionError = 0.f;
+    float normalError = 0.f;
+    float textureError = 0.f;
+    size_t zeroNormals = 0;
+    size_t index = 0;
+
+    for (size_t face = 0; face < mesh.faces.size(); ++face) {
+        check(compressed.faceFirsts[face] == (int32_t) index, "face first vertex", path, index);
+        check(compressed.faceSizes[face] == (int32_t) mesh.faces[face].vertices.size(), "face size", path, index);
+
+        for (const FaceVertex &vertex : mesh.faces[face].vertices) {
+            check(near(streams.positions[index], scalarStreams.positions[index], 1e-6f), "SSE/scalar position",
+                  path, index);
+            check(near(streams.normals[index], scalarStreams.normals[index], 1e-6f), "SSE/scalar normal",
+                  path, index);
+            check(streams.textures[index] == scalarStreams.textures[index], "SSE/scalar texture", path, index);
+
+            Vec3 d = streams.positions[index] - vertex.position;
+            float error = std::fmax(std::fabs(d.x), std::fmax(std::fabs(d.y), std::fabs(d.z)));
+            positionError = std::fmax(positionError, error);
+            check(error <= maxPositionError, "position error bound", path, index);
+
+            Vec3 normal = normalize(vertex.normal);
+            const int8_t *normal8 = &normals8[3 * index];
+            Vec3 decoded8(normal8[0] / 127.f, normal8[1] / 127.f, normal8[2] / 127.f);
+            if (normal == Vec3()) {
+                zeroNormals++;
+                check(streams.normals[index] == Vec3(), "zero normal stays zero", path, index);
+                check(decoded8 == Vec3(), "zero GL_BYTE normal stays zero", path, index);
+            } else {
+                float angle = angleBetween(normal, streams.normals[index]);
+                normalError = std::fmax(normalError, angle);
+                check(angle <= MAX_NORMAL_ERROR, "normal error bound", path, index);
+                check(length(decoded8 - normal) <= MAX_SNORM8_NORMAL_ERROR, "GL_BYTE normal error bound",
+                      path, index);
+            }
+
+            const float expected[2] = {vertex.texture.x, vertex.texture.y};
+            const float actual[2] = {streams.textures[index].x, streams.textures[index].y};
+            for (int k = 0; k < 2; ++k) {
+                float difference = std::fabs(actual[k] - expected[k]);
+                textureError = std::fmax(textureError, difference / std::fmax(std::fabs(expected[k]), 1e-30f));
+                check(difference <= std::fabs(expected[k]) * HALF_RELATIVE_ERROR + HALF_ABSOLUTE_ERROR,
+                      "texture error bound", path, index);
+            }
+            check(streams.textures[index].z == 0.f, "texture w is dropped", path, index);
+
+            index++;
+        }
+    }
+    check(index == compressed.vertexCount(), "vertex count", path, index);
+
+    // Как в main: после распаковки в GL_BYTE октаэдрические нормали освобождаются.
+    compressed.normals = CountedVector<int16_t>();
+    size_t floatBytes = index * sizeof(FaceVertex) + mesh.faces.size() * sizeof(Face);
+    size_t compressedBytes = compressed.residentSize() + normals8.size();
+    std::printf("%s: %zu vertices, position error %.3g (bound %.3g), normal error %.3g rad, "
+                "texture relative error %.3g, %zu zero normals; "
+                "resident %zu -> %zu bytes, per frame %zu -> %zu bytes\n",
+                path, index, positionError, maxPositionError, normalError, textureError, zeroNormals,
+                floatBytes, compressedBytes, index * sizeof(FaceVertex),
+                index * (3 * sizeof(int16_t) + 3 * sizeof(int8_t) + 2 * sizeof(uint16_t)));
+}
+
+int main(int argc, char **argv) {
+    checkHalfRoundTrip();
+    return test_support::for_each_mesh(argc, argv, checkMesh);
+}
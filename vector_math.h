@@ -0,0 +1,343 @@
+#ifndef GRAPHICS_LAB2_VECTOR_MATH_H
+#define GRAPHICS_LAB2_VECTOR_MATH_H
+
+#include <cmath>
+#include <cstddef>
+
+// VECTOR_MATH_NO_SIMD оставляет только скалярный код, чтобы его можно было собрать и проверить отдельно.
+#if !defined(VECTOR_MATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define VECTOR_MATH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace vector_math {
+
+    /**
+     * Трёхмерный вектор или точка одинарной точности.
+     * Без выравнивания, чтобы массивы атрибутов оставались плотными.
+     */
+    struct Vec3 {
+        float x = 0.f;
+        float y = 0.f;
+        float z = 0.f;
+
+        constexpr Vec3() = default;
+
+        constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+        const float *data() const { return &x; }
+
+        float *data() { return &x; }
+    };
+
+    struct alignas(16) Vec4 {
+        float x = 0.f;
+        float y = 0.f;
+        float z = 0.f;
+        float w = 0.f;
+
+        constexpr Vec4() = default;
+
+        constexpr Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        constexpr Vec4(const Vec3 &v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+        constexpr Vec3 xyz() const { return {x, y, z}; }
+
+        const float *data() const { return &x; }
+
+        float *data() { return &x; }
+    };
+
+    constexpr Vec3 operator+(const Vec3 &a, const Vec3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+
+    constexpr Vec3 operator-(const Vec3 &a, const Vec3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+
+    constexpr Vec3 operator-(const Vec3 &a) { return {-a.x, -a.y, -a.z}; }
+
+    constexpr Vec3 operator*(const Vec3 &a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+
+    constexpr Vec3 operator*(float s, const Vec3 &a) { return a * s; }
+
+    constexpr Vec3 operator/(const Vec3 &a, float s) { return {a.x / s, a.y / s, a.z / s}; }
+
+    constexpr bool operator==(const Vec3 &a, const Vec3 &b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+    constexpr bool operator!=(const Vec3 &a, const Vec3 &b) { return !(a == b); }
+
+    constexpr float dot(const Vec3 &a, const Vec3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    constexpr Vec3 cross(const Vec3 &a, const Vec3 &b) {
+        return {a.y * b.z - a.z * b.y,
+                a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x};
+    }
+
+    constexpr Vec3 min(const Vec3 &a, const Vec3 &b) {
+        return {a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z};
+    }
+
+    constexpr Vec3 max(const Vec3 &a, const Vec3 &b) {
+        return {a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z};
+    }
+
+    inline float length(const Vec3 &a) { return std::sqrt(dot(a, a)); }
+
+    /**
+     * Нормирует вектор; нулевой вектор возвращается без изменений.
+     */
+    inline Vec3 normalize(const Vec3 &a) {
+        float len = length(a);
+        return len > 0.f ? a / len : a;
+    }
+
+    /**
+     * Матрица 4×4, хранимая по столбцам, как её ожидает OpenGL (glMultMatrixf).
+     */
+    struct alignas(16) Mat4 {
+        float m[16] = {};
+
+        constexpr float operator()(int row, int column) const { return m[column * 4 + row]; }
+
+        float &operator()(int row, int column) { return m[column * 4 + row]; }
+
+        const float *data() const { return m; }
+
+        static constexpr Mat4 diagonal(float x, float y, float z, float w) {
+            return Mat4{{x, 0.f, 0.f, 0.f,
+                         0.f, y, 0.f, 0.f,
+                         0.f, 0.f, z, 0.f,
+                         0.f, 0.f, 0.f, w}};
+        }
+
+        static constexpr Mat4 identity() { return diagonal(1.f, 1.f, 1.f, 1.f); }
+
+        static constexpr Mat4 scale(float s) { return diagonal(s, s, s, 1.f); }
+
+        static constexpr Mat4 translation(const Vec3 &t) {
+            return Mat4{{1.f, 0.f, 0.f, 0.f,
+                         0.f, 1.f, 0.f, 0.f,
+                         0.f, 0.f, 1.f, 0.f,
+                         t.x, t.y, t.z, 1.f}};
+        }
+
+        /**
+         * Поворот на угол в градусах вокруг оси, как у glRotatef.
+         */
+        static Mat4 rotation(float degrees, const Vec3 &axis) {
+            Vec3 a = normalize(axis);
+            float radians = degrees * 3.14159265358979323846f / 180.f;
+            float c = std::cos(radians);
+            float s = std::sin(radians);
+            float t = 1.f - c;
+            return Mat4{{t * a.x * a.x + c, t * a.x * a.y + s * a.z, t * a.x * a.z - s * a.y, 0.f,
+                         t * a.x * a.y - s * a.z, t * a.y * a.y + c, t * a.y * a.z + s * a.x, 0.f,
+                         t * a.x * a.z + s * a.y, t * a.y * a.z - s * a.x, t * a.z * a.z + c, 0.f,
+                         0.f, 0.f, 0.f, 1.f}};
+        }
+
+        /**
+         * Видовая матрица, совпадающая с результатом gluLookAt.
+         */
+        static Mat4 look_at(const Vec3 &eye, const Vec3 &center, const Vec3 &up) {
+            Vec3 f = normalize(center - eye);
+            Vec3 s = normalize(cross(f, up));
+            Vec3 u = cross(s, f);
+            return Mat4{{s.x, u.x, -f.x, 0.f,
+                         s.y, u.y, -f.y, 0.f,
+                         s.z, u.z, -f.z, 0.f,
+                         -dot(s, eye), -dot(u, eye), dot(f, eye), 1.f}};
+        }
+    };
+
+    inline Mat4 operator*(const Mat4 &a, const Mat4 &b) {
+        Mat4 result;
+#ifdef VECTOR_MATH_SSE
+        __m128 c0 = _mm_load_ps(a.m);
+        __m128 c1 = _mm_load_ps(a.m + 4);
+        __m128 c2 = _mm_load_ps(a.m + 8);
+        __m128 c3 = _mm_load_ps(a.m + 12);
+        for (int column = 0; column < 4; ++column) {
+            const float *bc = b.m + column * 4;
+            __m128 r = _mm_mul_ps(c0, _mm_set1_ps(bc[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(bc[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(bc[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(bc[3])));
+            _mm_store_ps(result.m + column * 4, r);
+        }
+#else
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                result(row, column) = a(row, 0) * b(0, column) + a(row, 1) * b(1, column)
+                                      + a(row, 2) * b(2, column) + a(row, 3) * b(3, column);
+            }
+        }
+#endif
+        return result;
+    }
+
+    constexpr Vec4 operator*(const Mat4 &a, const Vec4 &v) {
+        return {a(0, 0) * v.x + a(0, 1) * v.y + a(0, 2) * v.z + a(0, 3) * v.w,
+                a(1, 0) * v.x + a(1, 1) * v.y + a(1, 2) * v.z + a(1, 3) * v.w,
+                a(2, 0) * v.x + a(2, 1) * v.y + a(2, 2) * v.z + a(2, 3) * v.w,
+                a(3, 0) * v.x + a(3, 1) * v.y + a(3, 2) * v.z + a(3, 3) * v.w};
+    }
+
+    /**
+     * Преобразует точку аффинной матрицей (w = 1, без перспективного деления).
+     */
+    constexpr Vec3 transform_point(const Mat4 &a, const Vec3 &p) {
+        return (a * Vec4(p, 1.f)).xyz();
+    }
+
+#ifdef VECTOR_MATH_SSE
+    namespace detail {
+        template<int s0, int s1, int s2, int s3>
+        inline __m128 shuffle(__m128 a, __m128 b) {
+            return _mm_shuffle_ps(a, b, _MM_SHUFFLE(s3, s2, s1, s0));
+        }
+
+        /**
+         * Переставляет четыре подряд идущих Vec3 (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3)
+         * в три регистра x, y, z.
+         */
+        inline void load4(const Vec3 *source, __m128 &x, __m128 &y, __m128 &z) {
+            const float *p = source->data();
+            __m128 a = _mm_loadu_ps(p);
+            __m128 b = _mm_loadu_ps(p + 4);
+            __m128 c = _mm_loadu_ps(p + 8);
+            x = shuffle<0, 3, 0, 2>(a, shuffle<2, 2, 1, 1>(b, c));
+            y = shuffle<0, 2, 0, 2>(shuffle<1, 1, 0, 0>(a, b), shuffle<3, 3, 2, 2>(b, c));
+            z = shuffle<0, 2, 0, 3>(shuffle<2, 2, 1, 1>(a, b), c);
+        }
+
+        inline void store4(Vec3 *destination, __m128 x, __m128 y, __m128 z) {
+            float *p = destination->data();
+            _mm_storeu_ps(p, shuffle<0, 2, 0, 2>(shuffle<0, 0, 0, 0>(x, y), shuffle<0, 0, 1, 1>(z, x)));
+            _mm_storeu_ps(p + 4, shuffle<0, 2, 0, 2>(shuffle<1, 1, 1, 1>(y, z), shuffle<2, 2, 2, 2>(x, y)));
+            _mm_storeu_ps(p + 8, shuffle<0, 2, 0, 2>(shuffle<2, 2, 3, 3>(z, x), shuffle<3, 3, 3, 3>(y, z)));
+        }
+    }
+#endif
+
+    /**
+     * Преобразует count точек матрицей; source и destination могут совпадать.
+     */
+    inline void transform_points(const Mat4 &matrix, const Vec3 *source, Vec3 *destination, size_t count) {
+        size_t i = 0;
+#ifdef VECTOR_MATH_SSE
+        __m128 m[12];
+        for (int k = 0; k < 12; ++k) m[k] = _mm_set1_ps(matrix.m[(k / 3) * 4 + k % 3]);
+        for (; i + 4 <= count; i += 4) {
+            __m128 x, y, z;
+            detail::load4(source + i, x, y, z);
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[3], y)),
+                                   _mm_add_ps(_mm_mul_ps(m[6], z), m[9]));
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[1], x), _mm_mul_ps(m[4], y)),
+                                   _mm_add_ps(_mm_mul_ps(m[7], z), m[10]));
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[2], x), _mm_mul_ps(m[5], y)),
+                                   _mm_add_ps(_mm_mul_ps(m[8], z), m[11]));
+            detail::store4(destination + i, rx, ry, rz);
+        }
+#endif
+        for (; i < count; ++i) {
+            destination[i] = transform_point(matrix, source[i]);
+        }
+    }
+
+    /**
+     * Нормирует count векторов на месте; нулевые векторы не меняются.
+     */
+    inline void normalize_all(Vec3 *vectors, size_t count) {
+        size_t i = 0;
+#ifdef VECTOR_MATH_SSE
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 x, y, z;
+            detail::load4(vectors + i, x, y, z);
+            __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            __m128 len = _mm_sqrt_ps(squared);
+            __m128 nonZero = _mm_cmpgt_ps(len, zero);
+            __m128 inverse = _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.f), len));
+            inverse = _mm_or_ps(inverse, _mm_andnot_ps(nonZero, _mm_set1_ps(1.f)));
+            detail::store4(vectors + i, _mm_mul_ps(x, inverse), _mm_mul_ps(y, inverse), _mm_mul_ps(z, inverse));
+        }
+#endif
+        for (; i < count; ++i) {
+            vectors[i] = normalize(vectors[i]);
+        }
+    }
+
+    /**
+     * destination[i] = cross(a[i], b[i]) для count пар векторов; destination может совпадать с a или b.
+     */
+    inline void cross_all(const Vec3 *a, const Vec3 *b, Vec3 *destination, size_t count) {
+        size_t i = 0;
+#ifdef VECTOR_MATH_SSE
+        for (; i + 4 <= count; i += 4) {
+            __m128 ax, ay, az, bx, by, bz;
+            detail::load4(a + i, ax, ay, az);
+            detail::load4(b + i, bx, by, bz);
+            detail::store4(destination + i,
+                           _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)),
+                           _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)),
+                           _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+        }
+#endif
+        for (; i < count; ++i) {
+            destination[i] = cross(a[i], b[i]);
+        }
+    }
+
+    /**
+     * Ограничивающий параллелепипед, выровненный по осям.
+     */
+    struct Bounds {
+        Vec3 min;
+        Vec3 max;
+
+        constexpr Vec3 center() const { return (min + max) * .5f; }
+
+        constexpr Vec3 extent() const { return max - min; }
+    };
+
+    /**
+     * Вычисляет границы count точек; для пустого массива возвращает нулевые границы.
+     */
+    inline Bounds compute_bounds(const Vec3 *points, size_t count) {
+        if (count == 0) return Bounds();
+        Bounds bounds{points[0], points[0]};
+        size_t i = 0;
+#ifdef VECTOR_MATH_SSE
+        if (count >= 4) {
+            __m128 minX, minY, minZ;
+            detail::load4(points, minX, minY, minZ);
+            __m128 maxX = minX, maxY = minY, maxZ = minZ;
+            for (i = 4; i + 4 <= count; i += 4) {
+                __m128 x, y, z;
+                detail::load4(points + i, x, y, z);
+                minX = _mm_min_ps(minX, x);
+                minY = _mm_min_ps(minY, y);
+                minZ = _mm_min_ps(minZ, z);
+                maxX = _mm_max_ps(maxX, x);
+                maxY = _mm_max_ps(maxY, y);
+                maxZ = _mm_max_ps(maxZ, z);
+            }
+            alignas(16) Vec3 lanes[8];
+            detail::store4(lanes, minX, minY, minZ);
+            detail::store4(lanes + 4, maxX, maxY, maxZ);
+            for (int lane = 0; lane < 4; ++lane) {
+                bounds.min = min(bounds.min, lanes[lane]);
+                bounds.max = max(bounds.max, lanes[4 + lane]);
+            }
+        }
+#endif
+        for (; i < count; ++i) {
+            bounds.min = min(bounds.min, points[i]);
+            bounds.max = max(bounds.max, points[i]);
+        }
+        return bounds;
+    }
+}
+
+#endif //GRAPHICS_LAB2_VECTOR_MATH_H
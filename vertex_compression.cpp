@@ -0,0 +1,311 @@
+#include <cmath>
+#include <cstring>
+#include "vertex_compression.h"
+
+#if defined(VECTOR_MATH_SSE) && (defined(__SSE2__) || defined(_M_X64))
+#define VERTEX_COMPRESSION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace vector_math;
+
+namespace vertex_compression {
+
+    static const float SNORM16_MAX = 32767.f;
+
+    uint16_t float_to_half(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        uint32_t magnitude = bits & 0x7fffffffu;
+
+        if (magnitude >= 0x7f800000u) {
+            // Бесконечность или NaN
+            return (uint16_t) (sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+        }
+        if (magnitude >= 0x477ff000u) {
+            // После округления не помещается в 65504
+            return (uint16_t) (sign | 0x7c00u);
+        }
+        if (magnitude < 0x38800000u) {
+            // Денормализованное число: шаг 2^-24, округление к ближайшему чётному
+            float absolute;
+            memcpy(&absolute, &magnitude, sizeof(absolute));
+            return (uint16_t) (sign | (uint32_t) std::nearbyint(absolute * 16777216.f));
+        }
+
+        uint32_t rounded = magnitude + 0xfffu + ((magnitude >> 13) & 1u);
+        return (uint16_t) (sign | ((rounded - 0x38000000u) >> 13));
+    }
+
+    float half_to_float(uint16_t half) {
+        uint32_t magnitudeBits = (uint32_t) (half & 0x7fffu) << 13;
+        float magnitude;
+        memcpy(&magnitude, &magnitudeBits, sizeof(magnitude));
+        magnitude *= 5.192296858534828e+33f; // 2^112 переносит показатель из 15 в 127
+
+        uint32_t bits;
+        memcpy(&bits, &magnitude, sizeof(bits));
+        if ((half & 0x7c00u) == 0x7c00u) bits |= 0x7f800000u;
+        bits |= (uint32_t) (half & 0x8000u) << 16;
+
+        float result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    static int16_t quantizeSnorm16(float value) {
+        value = value < -1.f ? -1.f : (value > 1.f ? 1.f : value);
+        return (int16_t) std::lround(value * SNORM16_MAX);
+    }
+
+    int16_t quantize_snorm16(float value, float center, float halfExtent) {
+        if (halfExtent <= 0.f) return 0;
+        return quantizeSnorm16((value - center) / halfExtent);
+    }
+
+    /**
+     * Половина наибольшего размера границ: все оси квантуются с одним шагом,
+     * чтобы матрица распаковки была равномерным масштабом и не искажала нормали в OpenGL.
+     */
+    static float halfCubeExtent(const Bounds &bounds) {
+        Vec3 extent = bounds.extent();
+        return std::fmax(extent.x, std::fmax(extent.y, extent.z)) * .5f;
+    }
+
+    static Vec3 positionStep(const Bounds &bounds) {
+        float step = halfCubeExtent(bounds) / SNORM16_MAX;
+        return {step, step, step};
+    }
+
+    Mat4 CompressedMesh::positionDecodeMatrix() const {
+        Vec3 step = positionStep(bounds);
+        return Mat4::translation(bounds.center()) * Mat4::scale(step.x);
+    }
+
+    void encode_octahedral(const Vec3 &normal, int16_t encoded[2]) {
+        float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+        if (sum == 0.f) {
+            encoded[0] = ZERO_NORMAL_CODE;
+            encoded[1] = ZERO_NORMAL_CODE;
+            return;
+        }
+
+        float u = normal.x / sum;
+        float v = normal.y / sum;
+        if (normal.z < 0.f) {
+            float foldedU = (1.f - std::fabs(v)) * (u >= 0.f ? 1.f : -1.f);
+            float foldedV = (1.f - std::fabs(u)) * (v >= 0.f ? 1.f : -1.f);
+            u = foldedU;
+            v = foldedV;
+        }
+
+        encoded[0] = quantizeSnorm16(u);
+        encoded[1] = quantizeSnorm16(v);
+    }
+
+    static Vec3 unfoldOctahedral(float u, float v) {
+        float z = 1.f - std::fabs(u) - std::fabs(v);
+        float t = z < 0.f ? -z : 0.f;
+        return normalize(Vec3(u - std::copysign(t, u), v - std::copysign(t, v), z));
+    }
+
+    Vec3 decode_octahedral(const int16_t encoded[2]) {
+        if (encoded[0] == ZERO_NORMAL_CODE && encoded[1] == ZERO_NORMAL_CODE) return Vec3();
+        float u = std::fmax(encoded[0] / SNORM16_MAX, -1.f);
+        float v = std::fmax(encoded[1] / SNORM16_MAX, -1.f);
+        return unfoldOctahedral(u, v);
+    }
+
+    struct CompressedFaceVertex {
+        int16_t position[3];
+        int16_t normal[2];
+        uint16_t texture[2];
+    };
+
+    static CompressedFaceVertex compressVertex(const FaceVertex &vertex, const Bounds &bounds) {
+        Vec3 center = bounds.center();
+        float halfExtent = halfCubeExtent(bounds);
+        CompressedFaceVertex result{};
+        result.position[0] = quantize_snorm16(vertex.position.x, center.x, halfExtent);
+        result.position[1] = quantize_snorm16(vertex.position.y, center.y, halfExtent);
+        result.position[2] = quantize_snorm16(vertex.position.z, center.z, halfExtent);
+        encode_octahedral(vertex.normal, result.normal);
+        result.texture[0] = float_to_half(vertex.texture.x);
+        result.texture[1] = float_to_half(vertex.texture.y);
+        return result;
+    }
+
+    CompressedMesh compress(const Mesh &mesh) {
+        size_t vertexCount = mesh.faceVertices.size();
+
+        CompressedMesh result;
+        result.bounds = mesh.bounds;
+        result.positions.reserve(vertexCount * 3);
+        result.normals.reserve(vertexCount * 2);
+        result.textures.reserve(vertexCount * 2);
+        result.faceFirsts.reserve(mesh.faces.size());
+        result.faceSizes.reserve(mesh.faces.size());
+
+        for (const Face &face : mesh.faces) {
+            result.faceFirsts.push_back((int32_t) result.vertexCount());
+            result.faceSizes.push_back((int32_t) face.vertices.size());
+            for (const FaceVertex &vertex : face.vertices) {
+                CompressedFaceVertex compressed = compressVertex(vertex, mesh.bounds);
+                result.positions.insert(result.positions.end(), compressed.position, compressed.position + 3);
+                result.normals.insert(result.normals.end(), compressed.normal, compressed.normal + 2);
+                result.textures.insert(result.textures.end(), compressed.texture, compressed.texture + 2);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Поток позиций рассматривается как плоский массив x y z x y z ...;
+     * двенадцать чисел (четыре вершины) распаковываются за итерацию.
+     */
+    static void decodePositions(const CompressedMesh &mesh, Vec3 *destination, bool useSimd) {
+        size_t count = mesh.positions.size();
+        const int16_t *source = mesh.positions.data();
+        float *output = destination->data();
+        const Vec3 center = mesh.bounds.center();
+        const Vec3 step = positionStep(mesh.bounds);
+        size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+        const __m128 step0 = _mm_setr_ps(step.x, step.y, step.z, step.x);
+        const __m128 step1 = _mm_setr_ps(step.y, step.z, step.x, step.y);
+        const __m128 step2 = _mm_setr_ps(step.z, step.x, step.y, step.z);
+        const __m128 center0 = _mm_setr_ps(center.x, center.y, center.z, center.x);
+        const __m128 center1 = _mm_setr_ps(center.y, center.z, center.x, center.y);
+        const __m128 center2 = _mm_setr_ps(center.z, center.x, center.y, center.z);
+        for (; useSimd && i + 12 <= count; i += 12) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            __m128i high = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i + 8));
+            __m128 a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(low, low), 16));
+            __m128 b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(low, low), 16));
+            __m128 c = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(high, high), 16));
+            _mm_storeu_ps(output + i, _mm_add_ps(center0, _mm_mul_ps(a, step0)));
+            _mm_storeu_ps(output + i + 4, _mm_add_ps(center1, _mm_mul_ps(b, step1)));
+            _mm_storeu_ps(output + i + 8, _mm_add_ps(center2, _mm_mul_ps(c, step2)));
+        }
+#endif
+        const float centers[3] = {center.x, center.y, center.z};
+        const float steps[3] = {step.x, step.y, step.z};
+        for (; i < count; ++i) {
+            output[i] = centers[i % 3] + source[i] * steps[i % 3];
+        }
+    }
+
+    static void decodeNormals(const int16_t *source, Vec3 *destination, size_t count, bool useSimd) {
+        size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+        const __m128 inverseMax = _mm_set1_ps(1.f / SNORM16_MAX);
+        const __m128 minusOne = _mm_set1_ps(-1.f);
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signMask = _mm_set1_ps(-0.f);
+        const __m128i zeroNormalCode = _mm_set1_epi32(ZERO_NORMAL_CODE);
+        for (; useSimd && i + 4 <= count; i += 4) {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * i));
+            __m128i lowInts = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+            __m128i highInts = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+            __m128 lowZero = _mm_castsi128_ps(_mm_cmpeq_epi32(lowInts, zeroNormalCode));
+            __m128 highZero = _mm_castsi128_ps(_mm_cmpeq_epi32(highInts, zeroNormalCode));
+            __m128 isZeroNormal = _mm_and_ps(detail::shuffle<0, 2, 0, 2>(lowZero, highZero),
+                                             detail::shuffle<1, 3, 1, 3>(lowZero, highZero));
+            __m128 low = _mm_cvtepi32_ps(lowInts);
+            __m128 high = _mm_cvtepi32_ps(highInts);
+            __m128 u = _mm_max_ps(_mm_mul_ps(detail::shuffle<0, 2, 0, 2>(low, high), inverseMax), minusOne);
+            __m128 v = _mm_max_ps(_mm_mul_ps(detail::shuffle<1, 3, 1, 3>(low, high), inverseMax), minusOne);
+
+            __m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, u)), _mm_andnot_ps(signMask, v));
+            __m128 t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+            __m128 x = _mm_sub_ps(u, _mm_or_ps(t, _mm_and_ps(signMask, u)));
+            __m128 y = _mm_sub_ps(v, _mm_or_ps(t, _mm_and_ps(signMask, v)));
+
+            __m128 inverseLength = _mm_andnot_ps(isZeroNormal, _mm_div_ps(one, _mm_sqrt_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)))));
+            detail::store4(destination + i,
+                           _mm_mul_ps(x, inverseLength), _mm_mul_ps(y, inverseLength), _mm_mul_ps(z, inverseLength));
+        }
+#endif
+        for (; i < count; ++i) {
+            destination[i] = decode_octahedral(source + 2 * i);
+        }
+    }
+
+#ifdef VERTEX_COMPRESSION_SSE2
+
+    static __m128 halfToFloat4(__m128i halves) {
+        const __m128i exponentMask = _mm_set1_epi32(0x7c00);
+        __m128i magnitudeBits = _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x7fff)), 13);
+        __m128 magnitude = _mm_mul_ps(_mm_castsi128_ps(magnitudeBits), _mm_set1_ps(5.192296858534828e+33f));
+        __m128i infinityOrNan = _mm_cmpeq_epi32(_mm_and_si128(halves, exponentMask), exponentMask);
+        __m128i bits = _mm_or_si128(_mm_castps_si128(magnitude),
+                                    _mm_and_si128(infinityOrNan, _mm_set1_epi32(0x7f800000)));
+        bits = _mm_or_si128(bits, _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x8000)), 16));
+        return _mm_castsi128_ps(bits);
+    }
+
+#endif
+
+    static void decodeTextures(const CompressedMesh &mesh, Vec3 *destination, bool useSimd) {
+        size_t count = mesh.vertexCount();
+        const uint16_t *source = mesh.textures.data();
+        size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; useSimd && i + 4 <= count; i += 4) {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * i));
+            __m128 low = halfToFloat4(_mm_unpacklo_epi16(packed, zero));
+            __m128 high = halfToFloat4(_mm_unpackhi_epi16(packed, zero));
+            detail::store4(destination + i,
+                           detail::shuffle<0, 2, 0, 2>(low, high),
+                           detail::shuffle<1, 3, 1, 3>(low, high),
+                           _mm_setzero_ps());
+        }
+#endif
+        for (; i < count; ++i) {
+            destination[i] = Vec3(half_to_float(source[2 * i]), half_to_float(source[2 * i + 1]), 0.f);
+        }
+    }
+
+    static void decompressStreams(const CompressedMesh &mesh, VertexStreams &streams, bool useSimd) {
+        size_t count = mesh.vertexCount();
+        streams.positions.resize(count);
+        streams.normals.resize(count);
+        streams.textures.resize(count);
+        if (count == 0) return;
+
+        decodePositions(mesh, streams.positions.data(), useSimd);
+        decodeNormals(mesh.normals.data(), streams.normals.data(), count, useSimd);
+        decodeTextures(mesh, streams.textures.data(), useSimd);
+    }
+
+    void decompress(const CompressedMesh &mesh, VertexStreams &streams) {
+        decompressStreams(mesh, streams, true);
+    }
+
+    void decompress_scalar(const CompressedMesh &mesh, VertexStreams &streams) {
+        decompressStreams(mesh, streams, false);
+    }
+
+    void decode_normals_snorm8(const CompressedMesh &mesh, CountedVector<int8_t> &normals) {
+        size_t count = mesh.vertexCount();
+        normals.resize(count * 3);
+
+        // Нормали распаковываются блоками в буфер на стеке, чтобы не выделять float-копию всего потока.
+        const size_t blockSize = 256;
+        Vec3 block[blockSize];
+        for (size_t first = 0; first < count; first += blockSize) {
+            size_t blockCount = count - first < blockSize ? count - first : blockSize;
+            decodeNormals(mesh.normals.data() + 2 * first, block, blockCount, true);
+            int8_t *destination = normals.data() + 3 * first;
+            const float *decoded = block->data();
+            for (size_t i = 0; i < 3 * blockCount; ++i) {
+                destination[i] = (int8_t) std::lround(decoded[i] * 127.f);
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef GRAPHICS_LAB2_VERTEX_COMPRESSION_H
+#define GRAPHICS_LAB2_VERTEX_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "arena.h"
+#include "obj_loader.h"
+#include "vector_math.h"
+
+namespace vertex_compression {
+
+    /**
+     * Код нулевой нормали: кодировщик никогда не выдаёт -32768, поэтому пара (-32768, -32768) свободна.
+     */
+    static const int16_t ZERO_NORMAL_CODE = -32768;
+
+    /**
+     * Сжатая сетка. Атрибуты хранятся отдельными потоками, чтобы их можно было передавать в OpenGL
+     * и распаковывать векторными инструкциями; грань i занимает faceSizes[i] вершин, начиная с faceFirsts[i].
+     * Позиция — три 16-битных знаковых нормированных числа в кубе вокруг границ сетки (один шаг на все оси),
+     * нормаль — октаэдрическое кодирование в два 16-битных знаковых нормированных числа,
+     * текстурные координаты — две половинки (half float); третья компонента отбрасывается.
+     */
+    class CompressedMesh {
+    public:
+        vector_math::Bounds bounds;
+        CountedVector<int16_t> positions;
+        CountedVector<int16_t> normals;
+        CountedVector<uint16_t> textures;
+        CountedVector<int32_t> faceFirsts;
+        CountedVector<int32_t> faceSizes;
+
+        size_t faceCount() const { return faceFirsts.size(); }
+
+        size_t vertexCount() const { return positions.size() / 3; }
+
+        /**
+         * Сколько байт занимают потоки, которые сейчас хранятся; освобождённый поток не учитывается.
+         */
+        size_t residentSize() const {
+            return positions.size() * sizeof(int16_t) + normals.size() * sizeof(int16_t)
+                   + textures.size() * sizeof(uint16_t) + faceCount() * (sizeof(int32_t) + sizeof(int32_t));
+        }
+
+        /**
+         * Матрица, переводящая позиции, прочитанные как GL_SHORT, в координаты сетки.
+         */
+        vector_math::Mat4 positionDecodeMatrix() const;
+    };
+
+    /**
+     * Распакованные потоки атрибутов в float.
+     */
+    class VertexStreams {
+    public:
+        CountedVector<vector_math::Vec3> positions;
+        CountedVector<vector_math::Vec3> normals;
+        CountedVector<vector_math::Vec3> textures;
+    };
+
+    uint16_t float_to_half(float value);
+
+    float half_to_float(uint16_t half);
+
+    int16_t quantize_snorm16(float value, float center, float halfExtent);
+
+    void encode_octahedral(const vector_math::Vec3 &normal, int16_t encoded[2]);
+
+    /**
+     * Раскодирует нормаль; ZERO_NORMAL_CODE даёт нулевой вектор.
+     */
+    vector_math::Vec3 decode_octahedral(const int16_t encoded[2]);
+
+    /**
+     * Сжимает все вершины граней сетки; позиции квантуются относительно mesh.bounds.
+     */
+    CompressedMesh compress(const Mesh &mesh);
+
+    /**
+     * Распаковывает сжатую сетку в streams (SSE2, если доступно), переиспользуя уже выделенную в них память.
+     */
+    void decompress(const CompressedMesh &mesh, VertexStreams &streams);
+
+    /**
+     * То же, что decompress, но только скалярным кодом; эталон для проверки векторного пути.
+     */
+    void decompress_scalar(const CompressedMesh &mesh, VertexStreams &streams);
+
+    /**
+     * Раскодирует нормали один раз (SSE2, если доступно) в три знаковых байта на вершину,
+     * как их принимает glNormalPointer(GL_BYTE).
+     */
+    void decode_normals_snorm8(const CompressedMesh &mesh, CountedVector<int8_t> &normals);
+}
+
+#endif //GRAPHICS_LAB2_VERTEX_COMPRESSION_H